@@ -2,19 +2,125 @@
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <algorithm>
 
-Database::Database() : connection(nullptr) {}
+// Ключ advisory lock, чтобы миграции не применялись одновременно несколькими процессами
+static const char* MIGRATION_LOCK_KEY = "727100";
+
+// Миграции схемы: применяются по возрастанию версии, каждая ровно один раз
+static const std::vector<Migration> MIGRATIONS = {
+    {1, "create_tables",
+        "CREATE TABLE IF NOT EXISTS users ("
+        "    id SERIAL PRIMARY KEY,"
+        "    username VARCHAR(100) NOT NULL,"
+        "    password VARCHAR(255) NOT NULL,"
+        "    role VARCHAR(20) NOT NULL DEFAULT 'user'"
+        ");"
+        "CREATE TABLE IF NOT EXISTS integrators ("
+        "    id SERIAL PRIMARY KEY,"
+        "    name VARCHAR(255) NOT NULL,"
+        "    city VARCHAR(100) NOT NULL,"
+        "    description TEXT NOT NULL DEFAULT ''"
+        ");"},
+    {2, "create_indexes",
+        "CREATE UNIQUE INDEX IF NOT EXISTS users_username_idx ON users (username);"
+        "CREATE INDEX IF NOT EXISTS integrators_name_id_idx ON integrators (name, id);"
+        "CREATE INDEX IF NOT EXISTS integrators_city_idx ON integrators (city);",
+        "SELECT username FROM users GROUP BY username HAVING COUNT(*) > 1",
+        "users contains duplicate usernames, remove them before the unique index can be created"}
+};
+
+// Запросы, которые выполняются на каждый запрос к API
+static const char* SQL_AUTHENTICATE = "SELECT password, role FROM users WHERE username = $1";
+static const char* SQL_USER_ROLE = "SELECT role FROM users WHERE username = $1";
+static const char* SQL_ALL_INTEGRATORS = "SELECT id, name, city, description FROM integrators ORDER BY name, id";
+static const char* SQL_INTEGRATOR_BY_ID = "SELECT id, name, city, description FROM integrators WHERE id = $1";
+
+struct RegisteredStatement {
+    std::string name;
+    std::string sql;
+    std::vector<std::string> sample_params;
+    std::string expected_index;
+};
+
+// Запросы для проверки планов (EXPLAIN) в диагностическом режиме
+// и индексы, которые они должны использовать
+static const std::vector<RegisteredStatement> REGISTERED_STATEMENTS = {
+    {"authenticate_user", SQL_AUTHENTICATE, {"admin"}, "users_username_idx"},
+    {"get_user_role", SQL_USER_ROLE, {"admin"}, "users_username_idx"},
+    {"get_all_integrators", SQL_ALL_INTEGRATORS, {}, "integrators_name_id_idx"},
+    {"get_integrator_by_id", SQL_INTEGRATOR_BY_ID, {"1"}, "integrators_pkey"}
+};
+
+// Параметры соединений с репликами: недоступный или зависший хост не должен надолго
+// блокировать ни проверку, ни запрос (connect_timeout — при подключении,
+// keepalive/tcp_user_timeout — при обрыве сети, statement_timeout — при медленном сервере)
+static const char* REPLICA_CONN_OPTIONS =
+    " connect_timeout=2"
+    " keepalives=1 keepalives_idle=5 keepalives_interval=2 keepalives_count=2"
+    " tcp_user_timeout=5000"
+    " options='-c statement_timeout=5000'";
+
+// Максимальная пауза между повторными подключениями к недоступной реплике
+static const std::chrono::milliseconds MAX_REPLICA_BACKOFF(30000);
+
+// Позиция WAL в виде "16/B374D848" -> число; 0 (InvalidXLogRecPtr) при ошибке
+static uint64_t parseLsn(const std::string& text) {
+    size_t slash = text.find('/');
+    if (slash == std::string::npos) {
+        return 0;
+    }
+    
+    try {
+        uint64_t high = std::stoull(text.substr(0, slash), nullptr, 16);
+        uint64_t low = std::stoull(text.substr(slash + 1), nullptr, 16);
+        return (high << 32) | low;
+    } catch (const std::exception&) {
+        return 0;
+    }
+}
+
+// Позиция WAL primary через указанное соединение; 0, если узнать не удалось
+static uint64_t currentWalLsn(PGconn* conn) {
+    PGresult* res = PQexec(conn, "SELECT pg_current_wal_lsn()");
+    uint64_t lsn = 0;
+    if (PQresultStatus(res) == PGRES_TUPLES_OK && PQntuples(res) > 0) {
+        lsn = parseLsn(PQgetvalue(res, 0, 0));
+    }
+    
+    PQclear(res);
+    return lsn;
+}
+
+Database::Database() : connection(nullptr), checker_connection(nullptr) {}
 
 Database::~Database() {
     disconnect();
 }
 
+std::string Database::connectionString(const std::string& host, const std::string& port) const {
+    return "host=" + host +
+           " port=" + port +
+           " dbname=" + db_config.dbname +
+           " user=" + db_config.user +
+           " password=" + db_config.password;
+}
+
 bool Database::connect(const DBConfig& config) {
-    std::string conn_str = "host=" + config.host +
-                          " port=" + config.port +
-                          " dbname=" + config.dbname +
-                          " user=" + config.user +
-                          " password=" + config.password;
+    if (config.balancing != "round_robin" && config.balancing != "least_latency") {
+        std::cerr << "Unknown replica balancing mode: " << config.balancing
+                  << " (expected round_robin or least_latency)" << std::endl;
+        return false;
+    }
+    
+    if (config.replica_check_interval_ms <= 0 || config.sticky_ms <= 0 ||
+        config.max_replica_lag_bytes <= 0) {
+        std::cerr << "Replica check interval, sticky time and max replica lag must be positive" << std::endl;
+        return false;
+    }
+    
+    db_config = config;
+    std::string conn_str = connectionString(config.host, config.port);
     
     std::cout << "Connecting to: " << conn_str << std::endl;
     
@@ -26,14 +132,496 @@ bool Database::connect(const DBConfig& config) {
     }
     
     std::cout << "Connected to database successfully!" << std::endl;
+    
+    if (config.replicas.empty()) {
+        return true;
+    }
+    
+    // Реплики необязательны: недоступная реплика просто не получает запросов,
+    // подключение к ней повторяет фоновая проверка
+    checker_connection = PQconnectdb((conn_str + REPLICA_CONN_OPTIONS).c_str());
+    
+    for (const auto& host : config.replicas) {
+        auto replica = std::make_unique<Replica>();
+        replica->name = host.host + ":" + host.port;
+        replica->conn_str = connectionString(host.host, host.port) + REPLICA_CONN_OPTIONS;
+        replica->next_check_at = std::chrono::steady_clock::now();
+        replicas.push_back(std::move(replica));
+    }
+    
+    // Первая проверка синхронная, чтобы доступные реплики работали сразу после старта
+    checkReplicas();
+    
+    checker_stopping = false;
+    checker_thread = std::thread(&Database::runChecker, this);
+    
     return true;
 }
 
 void Database::disconnect() {
+    if (checker_thread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(checker_mutex);
+            checker_stopping = true;
+        }
+        checker_cv.notify_all();
+        checker_thread.join();
+    }
+    
     if (connection) {
         PQfinish(connection);
         connection = nullptr;
     }
+    
+    if (checker_connection) {
+        PQfinish(checker_connection);
+        checker_connection = nullptr;
+    }
+    
+    for (auto& replica : replicas) {
+        if (replica->connection) {
+            PQfinish(replica->connection);
+        }
+        if (replica->probe_connection) {
+            PQfinish(replica->probe_connection);
+        }
+    }
+    replicas.clear();
+}
+
+bool Database::ensureRequestConnection(Replica& replica) {
+    // Соединение занято запросом — значит живо; сам запрос ограничен statement_timeout
+    std::unique_lock<std::mutex> lock(replica.query_mutex, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        return true;
+    }
+    
+    if (replica.connection && PQstatus(replica.connection) == CONNECTION_OK) {
+        return true;
+    }
+    lock.unlock();
+    
+    // Подключаемся без блокировки и подменяем соединение, только если оно свободно
+    PGconn* fresh = PQconnectdb(replica.conn_str.c_str());
+    if (PQstatus(fresh) != CONNECTION_OK) {
+        std::cerr << "Replica " << replica.name << " connection failed: "
+                  << PQerrorMessage(fresh) << std::endl;
+        PQfinish(fresh);
+        return false;
+    }
+    
+    if (!lock.try_lock()) {
+        PQfinish(fresh);
+        return false;
+    }
+    
+    std::swap(replica.connection, fresh);
+    if (fresh) {
+        PQfinish(fresh);
+    }
+    
+    std::cout << "Connected to replica " << replica.name << std::endl;
+    return true;
+}
+
+void Database::checkReplica(Replica& replica, uint64_t primary_lsn) {
+    // Проверка идёт через отдельное соединение и никогда не ждёт запросов к реплике
+    if (!replica.probe_connection) {
+        replica.probe_connection = PQconnectdb(replica.conn_str.c_str());
+    } else if (PQstatus(replica.probe_connection) != CONNECTION_OK) {
+        PQreset(replica.probe_connection);
+    }
+    
+    bool ok = false;
+    bool standby = false;
+    uint64_t replay_lsn = 0;
+    double elapsed = 0;
+    
+    if (PQstatus(replica.probe_connection) == CONNECTION_OK) {
+        // Не-реплика (например, второй обычный Postgres) возвращает NULL
+        auto start = std::chrono::steady_clock::now();
+        PGresult* res = PQexec(replica.probe_connection, "SELECT pg_last_wal_replay_lsn()");
+        elapsed = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+        
+        if (PQresultStatus(res) == PGRES_TUPLES_OK && PQntuples(res) > 0) {
+            ok = true;
+            if (!PQgetisnull(res, 0, 0)) {
+                standby = true;
+                replay_lsn = parseLsn(PQgetvalue(res, 0, 0));
+            }
+        } else {
+            std::cerr << "Replica " << replica.name << " check failed: "
+                      << PQerrorMessage(replica.probe_connection) << std::endl;
+        }
+        PQclear(res);
+    } else {
+        std::cerr << "Replica " << replica.name << " connection failed: "
+                  << PQerrorMessage(replica.probe_connection) << std::endl;
+    }
+    
+    ok = ok && ensureRequestConnection(replica);
+    
+    std::lock_guard<std::mutex> lock(routing_mutex);
+    auto now = std::chrono::steady_clock::now();
+    
+    if (!ok) {
+        // Экспоненциальная пауза перед следующей попыткой
+        replica.healthy = false;
+        replica.failures++;
+        std::chrono::milliseconds backoff(
+            static_cast<long long>(db_config.replica_check_interval_ms) << std::min(replica.failures, 5));
+        replica.next_check_at = now + std::min(backoff, MAX_REPLICA_BACKOFF);
+        return;
+    }
+    
+    replica.failures = 0;
+    replica.latency_ms = replica.latency_ms == 0 ? elapsed : replica.latency_ms * 0.8 + elapsed * 0.2;
+    replica.next_check_at = now + std::chrono::milliseconds(db_config.replica_check_interval_ms);
+    
+    if (!standby) {
+        // Сервер сам является источником данных: отставания нет
+        replica.replay_lsn = UINT64_MAX;
+        replica.lag_bytes = 0;
+        replica.healthy = true;
+        return;
+    }
+    
+    replica.replay_lsn = replay_lsn;
+    
+    // Позиция primary неизвестна: отставание не пересчитываем и оставляем прежнее состояние
+    if (primary_lsn == 0) {
+        return;
+    }
+    
+    replica.lag_bytes = primary_lsn > replay_lsn ? static_cast<long long>(primary_lsn - replay_lsn) : 0;
+    replica.healthy = replica.lag_bytes <= db_config.max_replica_lag_bytes;
+}
+
+void Database::checkReplicas() {
+    uint64_t primary_lsn = 0;
+    if (PQstatus(checker_connection) != CONNECTION_OK) {
+        PQreset(checker_connection);
+    }
+    if (PQstatus(checker_connection) == CONNECTION_OK) {
+        primary_lsn = currentWalLsn(checker_connection);
+    }
+    
+    if (primary_lsn == 0) {
+        std::cerr << "Primary WAL position unknown, replica lag is not updated: "
+                  << PQerrorMessage(checker_connection) << std::endl;
+    }
+    
+    for (auto& replica : replicas) {
+        bool due;
+        {
+            std::lock_guard<std::mutex> lock(routing_mutex);
+            due = std::chrono::steady_clock::now() >= replica->next_check_at;
+        }
+        if (due) {
+            checkReplica(*replica, primary_lsn);
+        }
+    }
+}
+
+void Database::runChecker() {
+    std::unique_lock<std::mutex> lock(checker_mutex);
+    
+    while (!checker_stopping) {
+        checker_cv.wait_for(lock, std::chrono::milliseconds(db_config.replica_check_interval_ms),
+                            [this]() { return checker_stopping; });
+        if (checker_stopping) {
+            break;
+        }
+        
+        lock.unlock();
+        checkReplicas();
+        lock.lock();
+    }
+}
+
+Replica* Database::pickReplica(const std::string& session_user) {
+    std::lock_guard<std::mutex> lock(routing_mutex);
+    auto now = std::chrono::steady_clock::now();
+    
+    // Read-your-writes: после своей записи пользователь читает только с реплик,
+    // которые уже применили эту запись, но не дольше sticky_ms
+    uint64_t min_lsn = 0;
+    if (!session_user.empty()) {
+        auto it = last_writes.find(session_user);
+        if (it != last_writes.end()) {
+            if (now - it->second.at < std::chrono::milliseconds(db_config.sticky_ms)) {
+                min_lsn = it->second.lsn;
+            } else {
+                last_writes.erase(it);
+            }
+        }
+    }
+    
+    Replica* chosen = nullptr;
+    if (db_config.balancing == "least_latency") {
+        for (auto& replica : replicas) {
+            if (replica->healthy && replica->replay_lsn >= min_lsn &&
+                (!chosen || replica->latency_ms < chosen->latency_ms)) {
+                chosen = replica.get();
+            }
+        }
+    } else {
+        for (size_t i = 0; i < replicas.size(); i++) {
+            Replica* replica = replicas[(next_replica + i) % replicas.size()].get();
+            if (replica->healthy && replica->replay_lsn >= min_lsn) {
+                chosen = replica;
+                next_replica = (next_replica + i + 1) % replicas.size();
+                break;
+            }
+        }
+    }
+    
+    return chosen;
+}
+
+void Database::markWrite(const std::string& session_user) {
+    if (session_user.empty() || replicas.empty()) {
+        return;
+    }
+    
+    // Если позицию записи узнать не удалось, пользователь читает с primary весь sticky_ms
+    uint64_t lsn = currentWalLsn(connection);
+    if (lsn == 0) {
+        lsn = UINT64_MAX;
+    }
+    
+    std::lock_guard<std::mutex> lock(routing_mutex);
+    last_writes[session_user] = {std::chrono::steady_clock::now(), lsn};
+}
+
+PGresult* Database::execRead(const char* sql, int n_params, const char* const* params,
+                             const std::string& session_user) {
+    Replica* replica = replicas.empty() ? nullptr : pickReplica(session_user);
+    
+    if (replica) {
+        PGresult* res;
+        bool connection_lost = false;
+        {
+            std::lock_guard<std::mutex> lock(replica->query_mutex);
+            res = PQexecParams(replica->connection, sql, n_params, NULL, params, NULL, NULL, 0);
+            
+            if (PQresultStatus(res) != PGRES_TUPLES_OK) {
+                std::cerr << "Replica " << replica->name << " read failed: "
+                          << PQerrorMessage(replica->connection) << std::endl;
+                
+                // Класс 08 — ошибки соединения; остальные ошибки относятся к самому запросу
+                const char* sqlstate = PQresultErrorField(res, PG_DIAG_SQLSTATE);
+                connection_lost = PQstatus(replica->connection) != CONNECTION_OK ||
+                                  (sqlstate && std::string(sqlstate).compare(0, 2, "08") == 0);
+                PQclear(res);
+                res = nullptr;
+            }
+        }
+        
+        if (res) {
+            return res;
+        }
+        
+        // Реплика потеряла соединение: выключаем её до следующей проверки.
+        // В любом случае этот запрос повторяем на primary
+        if (connection_lost) {
+            std::lock_guard<std::mutex> lock(routing_mutex);
+            replica->healthy = false;
+            replica->next_check_at = std::chrono::steady_clock::now();
+        }
+    }
+    
+    return PQexecParams(connection, sql, n_params, NULL, params, NULL, NULL, 0);
+}
+
+bool Database::execCommand(const std::string& sql) {
+    PGresult* res = PQexec(connection, sql.c_str());
+    ExecStatusType status = PQresultStatus(res);
+    bool success = (status == PGRES_COMMAND_OK || status == PGRES_TUPLES_OK);
+    
+    if (!success) {
+        std::cerr << "Query failed: " << PQerrorMessage(connection) << std::endl;
+    }
+    
+    PQclear(res);
+    return success;
+}
+
+bool Database::applyMigration(const Migration& migration) {
+    std::cout << "Applying migration " << migration.version << " (" << migration.name << ")" << std::endl;
+    
+    if (!migration.precheck.empty()) {
+        PGresult* res = PQexec(connection, migration.precheck.c_str());
+        if (PQresultStatus(res) != PGRES_TUPLES_OK) {
+            std::cerr << "Migration precheck failed: " << PQerrorMessage(connection) << std::endl;
+            PQclear(res);
+            return false;
+        }
+        
+        int rows = PQntuples(res);
+        if (rows > 0) {
+            std::cerr << "Migration " << migration.version << " (" << migration.name << "): "
+                      << migration.precheck_error << ":";
+            for (int i = 0; i < rows; i++) {
+                std::cerr << " '" << PQgetvalue(res, i, 0) << "'";
+            }
+            std::cerr << std::endl;
+            PQclear(res);
+            return false;
+        }
+        
+        PQclear(res);
+    }
+    
+    if (!execCommand("BEGIN")) {
+        return false;
+    }
+    
+    if (!execCommand(migration.sql)) {
+        execCommand("ROLLBACK");
+        return false;
+    }
+    
+    std::string version_str = std::to_string(migration.version);
+    const char* params[2] = {version_str.c_str(), migration.name.c_str()};
+    PGresult* res = PQexecParams(connection,
+        "INSERT INTO schema_migrations (version, name) VALUES ($1, $2)",
+        2, NULL, params, NULL, NULL, 0);
+    
+    bool success = (PQresultStatus(res) == PGRES_COMMAND_OK);
+    PQclear(res);
+    
+    if (!success) {
+        std::cerr << "Failed to record migration: " << PQerrorMessage(connection) << std::endl;
+        execCommand("ROLLBACK");
+        return false;
+    }
+    
+    return execCommand("COMMIT");
+}
+
+bool Database::migrate() {
+    const char* param = MIGRATION_LOCK_KEY;
+    PGresult* res = PQexecParams(connection,
+        "SELECT pg_advisory_lock($1::bigint)",
+        1, NULL, &param, NULL, NULL, 0);
+    bool locked = (PQresultStatus(res) == PGRES_TUPLES_OK);
+    PQclear(res);
+    
+    if (!locked) {
+        std::cerr << "Failed to acquire migration lock: " << PQerrorMessage(connection) << std::endl;
+        return false;
+    }
+    
+    bool success = execCommand(
+        "CREATE TABLE IF NOT EXISTS schema_migrations ("
+        "    version INTEGER PRIMARY KEY,"
+        "    name VARCHAR(100) NOT NULL,"
+        "    applied_at TIMESTAMP NOT NULL DEFAULT now()"
+        ")");
+    
+    // Версию читаем уже под блокировкой, чтобы не применить миграцию дважды
+    int current_version = 0;
+    if (success) {
+        res = PQexec(connection, "SELECT COALESCE(MAX(version), 0) FROM schema_migrations");
+        if (PQresultStatus(res) == PGRES_TUPLES_OK && PQntuples(res) > 0) {
+            current_version = std::stoi(PQgetvalue(res, 0, 0));
+        } else {
+            std::cerr << "Failed to read schema version: " << PQerrorMessage(connection) << std::endl;
+            success = false;
+        }
+        PQclear(res);
+    }
+    
+    for (const auto& migration : MIGRATIONS) {
+        if (!success) {
+            break;
+        }
+        if (migration.version > current_version) {
+            success = applyMigration(migration);
+        }
+    }
+    
+    res = PQexecParams(connection,
+        "SELECT pg_advisory_unlock($1::bigint)",
+        1, NULL, &param, NULL, NULL, 0);
+    PQclear(res);
+    
+    if (success) {
+        std::cout << "Database schema is up to date" << std::endl;
+    }
+    
+    return success;
+}
+
+bool Database::seedTestUsers() {
+    // Тестовые учётные записи из README; только для разработки (db_seed_test_users)
+    bool success = execCommand(
+        "INSERT INTO users (username, password, role) VALUES"
+        "    ('user1', 'password123', 'user'),"
+        "    ('admin', 'admin123', 'admin')"
+        "ON CONFLICT (username) DO NOTHING");
+    
+    if (success) {
+        std::cout << "Test users are present" << std::endl;
+    }
+    
+    return success;
+}
+
+nlohmann::json Database::explainStatements() {
+    nlohmann::json report = nlohmann::json::array();
+    
+    for (const auto& statement : REGISTERED_STATEMENTS) {
+        std::vector<const char*> params;
+        for (const auto& value : statement.sample_params) {
+            params.push_back(value.c_str());
+        }
+        
+        // На маленьких таблицах планировщик и так выбирает Seq Scan, поэтому
+        // запрещаем его и проверяем, что запрос вообще может использовать нужный индекс
+        if (!execCommand("BEGIN") || !execCommand("SET LOCAL enable_seqscan = off")) {
+            execCommand("ROLLBACK");
+            report.push_back({{"name", statement.name}, {"error", "failed to start plan check"}});
+            continue;
+        }
+        
+        std::string sql = "EXPLAIN " + statement.sql;
+        PGresult* res = PQexecParams(connection, sql.c_str(),
+            static_cast<int>(params.size()), NULL,
+            params.empty() ? NULL : params.data(), NULL, NULL, 0);
+        
+        nlohmann::json entry = {
+            {"name", statement.name},
+            {"sql", statement.sql},
+            {"expected_index", statement.expected_index}
+        };
+        
+        if (PQresultStatus(res) != PGRES_TUPLES_OK) {
+            entry["error"] = PQerrorMessage(connection);
+        } else {
+            nlohmann::json plan = nlohmann::json::array();
+            bool uses_index = false;
+            int rows = PQntuples(res);
+            for (int i = 0; i < rows; i++) {
+                std::string line = PQgetvalue(res, i, 0);
+                // "Index Scan using <index> on ...", "Bitmap Index Scan on <index>  (cost=...)"
+                if (line.find(" " + statement.expected_index + " ") != std::string::npos) {
+                    uses_index = true;
+                }
+                plan.push_back(line);
+            }
+            entry["plan"] = plan;
+            entry["uses_expected_index"] = uses_index;
+        }
+        
+        PQclear(res);
+        execCommand("ROLLBACK");
+        report.push_back(entry);
+    }
+    
+    return report;
 }
 
 bool Database::authenticateUser(const std::string& username, const std::string& password) {
@@ -41,7 +629,7 @@ bool Database::authenticateUser(const std::string& username, const std::string&
     
     const char* param = username.c_str();
     PGresult* res = PQexecParams(connection,
-        "SELECT password, role FROM users WHERE username = $1",
+        SQL_AUTHENTICATE,
         1, NULL, &param, NULL, NULL, 0);
     
     if (PQresultStatus(res) != PGRES_TUPLES_OK) {
@@ -74,9 +662,7 @@ bool Database::authenticateUser(const std::string& username, const std::string&
 
 std::string Database::getUserRole(const std::string& username) {
     const char* param = username.c_str();
-    PGresult* res = PQexecParams(connection,
-        "SELECT role FROM users WHERE username = $1",
-        1, NULL, &param, NULL, NULL, 0);
+    PGresult* res = execRead(SQL_USER_ROLE, 1, &param, username);
     
     std::string role = "";
     if (PQntuples(res) > 0) {
@@ -87,9 +673,8 @@ std::string Database::getUserRole(const std::string& username) {
     return role;
 }
 
-nlohmann::json Database::getAllIntegrators() {
-    PGresult* res = PQexec(connection, 
-        "SELECT id, name, city, description FROM integrators ORDER BY name");
+nlohmann::json Database::getAllIntegrators(const std::string& session_user) {
+    PGresult* res = execRead(SQL_ALL_INTEGRATORS, 0, NULL, session_user);
     
     nlohmann::json result = nlohmann::json::array();
     
@@ -108,13 +693,11 @@ nlohmann::json Database::getAllIntegrators() {
     return result;
 }
 
-nlohmann::json Database::getIntegratorById(int id) {
+nlohmann::json Database::getIntegratorById(int id, const std::string& session_user) {
     std::string id_str = std::to_string(id);
     const char* param = id_str.c_str();
     
-    PGresult* res = PQexecParams(connection,
-        "SELECT id, name, city, description FROM integrators WHERE id = $1",
-        1, NULL, &param, NULL, NULL, 0);
+    PGresult* res = execRead(SQL_INTEGRATOR_BY_ID, 1, &param, session_user);
     
     nlohmann::json integrator;
     if (PQntuples(res) > 0) {
@@ -129,7 +712,7 @@ nlohmann::json Database::getIntegratorById(int id) {
 }
 
 bool Database::addIntegrator(const std::string& name, const std::string& city,
-                           const std::string& description) {
+                           const std::string& description, const std::string& session_user) {
     const char* params[3] = {name.c_str(), city.c_str(), description.c_str()};
     
     PGresult* res = PQexecParams(connection,
@@ -138,7 +721,9 @@ bool Database::addIntegrator(const std::string& name, const std::string& city,
     
     bool success = (PQresultStatus(res) == PGRES_COMMAND_OK);
     
-    if (!success) {
+    if (success) {
+        markWrite(session_user);
+    } else {
         std::cerr << "DEBUG: Insert failed: " << PQerrorMessage(connection) << std::endl;
     }
     
@@ -148,7 +733,7 @@ bool Database::addIntegrator(const std::string& name, const std::string& city,
 }
 
 bool Database::updateIntegrator(int id, const std::string& name, const std::string& city,
-                              const std::string& description) {
+                              const std::string& description, const std::string& session_user) {
     std::string id_str = std::to_string(id);
     const char* params[4] = {id_str.c_str(), name.c_str(), city.c_str(), description.c_str()};
     
@@ -157,12 +742,17 @@ bool Database::updateIntegrator(int id, const std::string& name, const std::stri
         4, NULL, params, NULL, NULL, 0);
     
     bool success = (PQresultStatus(res) == PGRES_COMMAND_OK);
+    
+    if (success) {
+        markWrite(session_user);
+    }
+    
     PQclear(res);
     
     return success;
 }
 
-bool Database::deleteIntegrator(int id) {
+bool Database::deleteIntegrator(int id, const std::string& session_user) {
     std::string id_str = std::to_string(id);
     const char* param = id_str.c_str();
     
@@ -171,6 +761,11 @@ bool Database::deleteIntegrator(int id) {
         1, NULL, &param, NULL, NULL, 0);
     
     bool success = (PQresultStatus(res) == PGRES_COMMAND_OK);
+    
+    if (success) {
+        markWrite(session_user);
+    }
+    
     PQclear(res);
     
     return success;
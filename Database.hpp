@@ -4,22 +4,92 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <cstdint>
+#include <mutex>
+#include <memory>
+#include <thread>
+#include <chrono>
+#include <condition_variable>
 #include <libpq-fe.h>
 #include <nlohmann/json.hpp>
 
 using json = nlohmann::json;
 
-struct DBConfig {
+struct DBHost {
     std::string host;
     std::string port;
+};
+
+struct DBConfig {
+    std::string host;      // primary: все записи и миграции
+    std::string port;
     std::string dbname;
     std::string user;
     std::string password;
+    std::vector<DBHost> replicas;                 // реплики для чтения
+    std::string balancing = "round_robin";        // "round_robin" или "least_latency"
+    long long max_replica_lag_bytes = 1048576;    // реплики с большим отставанием по WAL не используются
+    int sticky_ms = 5000;                         // сколько читать с primary после записи пользователя
+    int replica_check_interval_ms = 1000;         // как часто проверять отставание реплик
+};
+
+struct Replica {
+    std::string name;
+    std::string conn_str;
+    PGconn* connection = nullptr;        // для запросов; защищено query_mutex
+    PGconn* probe_connection = nullptr;  // только для фоновой проверки, не ждёт запросов
+    std::mutex query_mutex;              // одно соединение выполняет один запрос за раз
+    
+    // Поля ниже защищены Database::routing_mutex
+    bool healthy = false;
+    double latency_ms = 0;               // время ответа на проверочный запрос (скользящее среднее)
+    long long lag_bytes = 0;
+    uint64_t replay_lsn = 0;             // позиция WAL, применённая на реплике при последней проверке
+    int failures = 0;
+    std::chrono::steady_clock::time_point next_check_at;
+};
+
+struct LastWrite {
+    std::chrono::steady_clock::time_point at;
+    uint64_t lsn;                        // позиция WAL primary сразу после записи
+};
+
+struct Migration {
+    int version;
+    std::string name;
+    std::string sql;
+    std::string precheck = "";        // запрос, возвращающий строки, мешающие миграции
+    std::string precheck_error = "";  // пояснение, если precheck вернул строки
 };
 
 class Database {
 private:
     PGconn* connection;
+    std::vector<std::unique_ptr<Replica>> replicas;
+    std::map<std::string, LastWrite> last_writes; // username -> последняя запись
+    std::mutex routing_mutex;
+    DBConfig db_config;
+    size_t next_replica = 0;
+    
+    // Фоновая проверка реплик: своё соединение с primary, чтобы не делить connection
+    PGconn* checker_connection;
+    std::thread checker_thread;
+    std::mutex checker_mutex;
+    std::condition_variable checker_cv;
+    bool checker_stopping = false;
+    
+    std::string connectionString(const std::string& host, const std::string& port) const;
+    bool ensureRequestConnection(Replica& replica);
+    void checkReplica(Replica& replica, uint64_t primary_lsn);  // primary_lsn == 0: позиция неизвестна
+    void checkReplicas();
+    void runChecker();
+    Replica* pickReplica(const std::string& session_user);
+    void markWrite(const std::string& session_user);
+    PGresult* execRead(const char* sql, int n_params, const char* const* params,
+                       const std::string& session_user);
+    
+    bool execCommand(const std::string& sql);
+    bool applyMigration(const Migration& migration);
     
 public:
     Database();
@@ -28,18 +98,24 @@ public:
     bool connect(const DBConfig& config);
     void disconnect();
     
+    // Schema operations
+    bool migrate();
+    bool seedTestUsers();
+    json explainStatements();
+    
     // User operations
     bool authenticateUser(const std::string& username, const std::string& password);
     std::string getUserRole(const std::string& username);
     
     // Integrator operations
-    json getAllIntegrators();
-    json getIntegratorById(int id);
+    // session_user: пользователь, от имени которого идёт запрос (для read-your-writes)
+    json getAllIntegrators(const std::string& session_user = "");
+    json getIntegratorById(int id, const std::string& session_user = "");
     bool addIntegrator(const std::string& name, const std::string& city, 
-                       const std::string& description);
+                       const std::string& description, const std::string& session_user = "");
     bool updateIntegrator(int id, const std::string& name, const std::string& city,
-                         const std::string& description);
-    bool deleteIntegrator(int id);
+                         const std::string& description, const std::string& session_user = "");
+    bool deleteIntegrator(int id, const std::string& session_user = "");
 };
 
 #endif
\ No newline at end of file
@@ -41,11 +41,40 @@ int main() {
         config["db_password"]
     };
     
+    // Реплики для чтения (необязательно)
+    if (config.contains("db_replicas")) {
+        for (const auto& replica : config["db_replicas"]) {
+            db_config.replicas.push_back({replica["host"], replica["port"]});
+        }
+    }
+    db_config.balancing = config.value("db_replica_balancing", db_config.balancing);
+    db_config.max_replica_lag_bytes = config.value("db_max_replica_lag_bytes", db_config.max_replica_lag_bytes);
+    db_config.sticky_ms = config.value("db_sticky_ms", db_config.sticky_ms);
+    db_config.replica_check_interval_ms = config.value("db_replica_check_interval_ms", db_config.replica_check_interval_ms);
+    
     if (!db.connect(db_config)) {
         std::cerr << "Failed to connect to database" << std::endl;
         return 1;
     }
     
+    // Создание и обновление схемы БД
+    if (!db.migrate()) {
+        std::cerr << "Failed to migrate database schema" << std::endl;
+        return 1;
+    }
+    
+    // Тестовые пользователи только по явному флагу (для разработки)
+    if (config.value("db_seed_test_users", false) && !db.seedTestUsers()) {
+        std::cerr << "Failed to seed test users" << std::endl;
+        return 1;
+    }
+    
+    // Диагностика: планы выполнения основных запросов
+    if (config.value("db_explain", false)) {
+        std::cout << "Query plans:" << std::endl;
+        std::cout << db.explainStatements().dump(2) << std::endl;
+    }
+    
     // Инициализация системы аутентификации
     Auth auth;
     
@@ -159,7 +188,7 @@ int main() {
             return crow::response(401, "Not authenticated");
         }
         
-        auto integrators_json = db.getAllIntegrators();
+        auto integrators_json = db.getAllIntegrators(username);
         crow::json::wvalue response;
         
         // Преобразуем nlohmann::json в crow::json
@@ -192,7 +221,7 @@ int main() {
             return crow::response(403, "Admin only");
         }
         
-        auto integrator_json = db.getIntegratorById(id);
+        auto integrator_json = db.getIntegratorById(id, username);
         if (integrator_json.empty()) {
             return crow::response(404, "Integrator not found");
         }
@@ -232,7 +261,7 @@ int main() {
             return crow::response(400, "Name and city are required");
         }
         
-        if (db.addIntegrator(name, city, description)) {
+        if (db.addIntegrator(name, city, description, username)) {
             return crow::response(201, "Integrator added");
         }
         
@@ -265,7 +294,7 @@ int main() {
             return crow::response(400, "Name and city are required");
         }
         
-        if (db.updateIntegrator(id, name, city, description)) {
+        if (db.updateIntegrator(id, name, city, description, username)) {
             return crow::response(200, "Integrator updated");
         }
         
@@ -285,7 +314,7 @@ int main() {
             return crow::response(403, "Admin only");
         }
         
-        if (db.deleteIntegrator(id)) {
+        if (db.deleteIntegrator(id, username)) {
             return crow::response(200, "Integrator deleted");
         }
         